@@ -0,0 +1,307 @@
+// bio 采集器：kprobe 挂在 submit_bio 上，把目标设备的每个 bio 记入计数核心，
+// 并提供 /proc/iomon/stats（聚合快照）、/proc/iomon/rates（滑动窗口速率）和阈值告警
+#include "iomon.h"
+
+#include <linux/blkdev.h>
+#include <linux/kprobes.h>
+#include <linux/moduleparam.h>
+#include <linux/slab.h>
+#include <linux/uaccess.h>
+
+#define STATS_PROC_NAME "stats"
+#define RATES_PROC_NAME "rates"
+
+static const char * const iomon_profile_names[] = {
+    [IOMON_PROFILE_DEVICE] = "device",
+    [IOMON_PROFILE_PROCESS] = "process",
+    [IOMON_PROFILE_FULL] = "full",
+};
+
+// 设备过滤规则（RCU保护）
+struct filter_rule {
+    dev_t dev;
+    bool track_read;
+    bool track_write;
+    struct rcu_head rcu;
+};
+static struct filter_rule __rcu *current_rule;
+// 不区分读写方向的档位只需设备号，处理函数直接读取这份副本
+static dev_t filter_dev;
+
+// 读/写方向开关，只有 full 档位的处理函数会检查
+static bool track_read = true;
+static bool track_write = true;
+
+static struct kprobe submit_bio_kp;
+
+// kprobe 前置处理函数：按编译期档位只保留所需的工作，读写方向用作数组下标而非分支
+static int submit_bio_entry_handler(struct kprobe *p, struct pt_regs *regs)
+{
+    // struct bio: 描述块设备 I/O 请求的核心结构，包含目标设备、读写方向、数据大小等信息
+    struct bio *bio = (struct bio *)regs->di;  // 第一个参数通常在 di 寄存器
+    unsigned long sec;
+    dev_t bio_dev;
+    u64 bytes;
+    int dir;
+
+    if (!bio || !bio->bi_bdev)
+        return 0;
+    //      IO请求-> IO设备 -> 设备号
+    bio_dev = bio->bi_bdev->bd_dev;
+    dir = bio_data_dir(bio);
+
+#if IOMON_DIR_FILTER
+    {
+        struct filter_rule *rule = rcu_dereference(current_rule);
+
+        if (!rule || bio_dev != rule->dev)
+            return 0;
+        if (!(dir == READ ? rule->track_read : rule->track_write))
+            return 0;
+    }
+#else
+    if (bio_dev != READ_ONCE(filter_dev))
+        return 0;
+#endif
+
+    bytes = bio->bi_iter.bi_size;
+    sec = iomon_rate_now();
+    iomon_account_dev(dir, bytes, sec);
+
+    if (IOMON_PER_PROCESS) {
+        struct iomon_proc_stats *stats = iomon_get_proc_stats(current);
+
+        if (stats)
+            iomon_account_proc(stats, dir, bytes, sec);
+    }
+
+    return 0;
+}
+
+// 更新过滤规则：通过 RCU 替换，不阻塞处理函数；调用方持有 kernel_param_lock，串行化写者
+static int update_rule(dev_t new_dev, bool track_r, bool track_w)
+{
+    struct filter_rule *new_rule = kmalloc(sizeof(*new_rule), GFP_KERNEL);
+    struct filter_rule *old_rule;
+
+    if (!new_rule)
+        return -ENOMEM;
+
+    new_rule->dev = new_dev;
+    new_rule->track_read = track_r;
+    new_rule->track_write = track_w;
+    WRITE_ONCE(filter_dev, new_dev);
+
+    old_rule = rcu_dereference_protected(current_rule, 1);
+    rcu_assign_pointer(current_rule, new_rule);
+    if (old_rule)
+        kfree_rcu(old_rule, rcu);
+    return 0;
+}
+
+#if IOMON_DIR_FILTER
+// 运行时修改方向开关时替换过滤规则。参数写入在 kernel_param_lock 下进行，
+// 加载时（规则尚未建立）只记录取值，由 bio_collector_init 使用
+static int track_param_set(const char *val, const struct kernel_param *kp)
+{
+    int ret = param_set_bool(val, kp);
+
+    if (ret || !rcu_access_pointer(current_rule))
+        return ret;
+    return update_rule(iomon_target_dev, READ_ONCE(track_read), READ_ONCE(track_write));
+}
+
+static const struct kernel_param_ops track_param_ops = {
+    .set = track_param_set,
+    .get = param_get_bool,
+};
+module_param_cb(track_read, &track_param_ops, &track_read, 0644);
+MODULE_PARM_DESC(track_read, "Account reads on the target device (full profile only)");
+module_param_cb(track_write, &track_param_ops, &track_write, 0644);
+MODULE_PARM_DESC(track_write, "Account writes on the target device (full profile only)");
+#endif
+
+// /proc/iomon/stats：显示全局和进程级统计（来自缓存快照），PID 为全局 PID，
+// NSPID 为进程在自己 PID 命名空间（PIDNS）内的 PID。
+// 向文件写入生成号 G 后再读，则只输出 G 之后有变化的进程，以及 G 之后被淘汰的进程；
+// G 小于淘汰记录的下界时部分淘汰记录已丢失，读者应写入 0 重新全量读取
+static int stats_show(struct seq_file *m, void *v)
+{
+    u64 since = *(u64 *)m->private;
+    struct iomon_snapshot *snap;
+    unsigned int i;
+    int ret;
+
+    ret = iomon_snapshot_update();
+    if (ret)
+        return ret;
+
+    rcu_read_lock();
+    snap = rcu_dereference(iomon_snapshot);
+    seq_printf(m, "Target Device: %d:%d\n", MAJOR(iomon_target_dev), MINOR(iomon_target_dev));
+    seq_printf(m, "Global Read: %llu bytes\n", snap->total_read);
+    seq_printf(m, "Global Write: %llu bytes\n", snap->total_write);
+    if (IOMON_PER_PROCESS) // 进程表满或分配失败时只计入总量、未按进程记账的 bio 数
+        seq_printf(m, "Untracked Bios: %llu\n", iomon_proc_untracked());
+    seq_printf(m, "Generation: %llu\n\n", snap->gen);
+    if (IOMON_PER_PROCESS) { // device 档位不输出进程级统计
+        seq_puts(m, "Per-Process Statistics:\n");
+        for (i = 0; i < snap->nr; i++) {
+            const struct iomon_snap_entry *e = &snap->ent[i];
+
+            if (e->changed_gen <= since)
+                continue;
+            seq_printf(m, "PID: %d, NSPID: %d, PIDNS: %u, Comm: %s, Read: %llu bytes, Write: %llu bytes\n",
+                       e->pid, e->ns_pid, e->pidns, e->comm, e->read_bytes, e->write_bytes);
+        }
+        if (since) {
+            seq_printf(m, "\nRemoved Processes (complete after generation %llu):\n",
+                       snap->removed_floor);
+            for (i = 0; i < snap->nr_removed; i++) {
+                const struct iomon_snap_entry *e = &snap->removed[i];
+
+                if (e->changed_gen <= since)
+                    continue;
+                seq_printf(m, "PID: %d, NSPID: %d, PIDNS: %u, Comm: %s, Removed: %llu\n",
+                           e->pid, e->ns_pid, e->pidns, e->comm, e->changed_gen);
+            }
+        }
+    }
+    rcu_read_unlock();
+    return 0;
+}
+
+// 每个打开者有自己的起始生成号，默认 0 即输出全部
+static int stats_open(struct inode *inode, struct file *file)
+{
+    u64 *since = kzalloc(sizeof(*since), GFP_KERNEL);
+    int ret;
+
+    if (!since)
+        return -ENOMEM;
+    ret = single_open(file, stats_show, since);
+    if (ret)
+        kfree(since);
+    return ret;
+}
+
+static ssize_t stats_write(struct file *file, const char __user *buf, size_t count, loff_t *ppos)
+{
+    struct seq_file *m = file->private_data;
+    int ret;
+
+    ret = kstrtoull_from_user(buf, count, 10, m->private);
+    return ret ? ret : count;
+}
+
+static int stats_release(struct inode *inode, struct file *file)
+{
+    struct seq_file *m = file->private_data;
+
+    kfree(m->private);
+    return single_release(inode, file);
+}
+
+IOMON_PROC_OPS(stats_fops, stats_open, seq_read, stats_write, NULL, seq_lseek, stats_release);
+
+// /proc/iomon/rates：显示设备和进程的 1s/10s/60s 滑动窗口速率，60s 内无 IO 的进程不输出；
+// 进程行依次为全局 PID、命名空间内 PID、COMM
+static int rates_show(struct seq_file *m, void *v)
+{
+    unsigned long now = iomon_rate_now();
+    struct iomon_proc_stats *stats;
+    struct iomon_rate_sum sum;
+    int i;
+
+    seq_printf(m, "Target Device: %d:%d\n", MAJOR(iomon_target_dev), MINOR(iomon_target_dev));
+    seq_printf(m, "%-32s", "WINDOW");
+    iomon_seq_rates_header(m);
+
+    iomon_rate_sum_dev(&sum, now);
+    seq_printf(m, "%-32s", "device");
+    iomon_seq_rates(m, &sum);
+    if (!IOMON_PER_PROCESS)
+        return 0;
+
+    rcu_read_lock();
+    for (i = 0; i < IOMON_HASH_SIZE; i++) {
+        hlist_for_each_entry_rcu(stats, &iomon_proc_table[i], hash_node) {
+            iomon_rate_sum_proc(&sum, stats, now);
+            if (!sum.ios[IOMON_RATE_NR_WINDOWS - 1][READ] &&
+                !sum.ios[IOMON_RATE_NR_WINDOWS - 1][WRITE])
+                continue;
+            seq_printf(m, "%-7d %-7d %-16s", stats->pid, stats->ns_pid, stats->comm);
+            iomon_seq_rates(m, &sum);
+        }
+    }
+    rcu_read_unlock();
+    return 0;
+}
+
+static int bio_collector_init(void)
+{
+    int ret;
+
+    kernel_param_lock(THIS_MODULE);
+    ret = update_rule(iomon_target_dev, track_read, track_write);
+    kernel_param_unlock(THIS_MODULE);
+    if (ret)
+        return ret;
+
+    ret = iomon_proc_create(STATS_PROC_NAME, 0644, &stats_fops);
+    if (ret)
+        goto err_rule;
+    ret = iomon_proc_create_single(RATES_PROC_NAME, rates_show);
+    if (ret)
+        goto err_stats;
+    ret = iomon_alert_init();
+    if (ret)
+        goto err_rates;
+
+    // 设置 kprobe 跟踪 submit_bio 函数
+    submit_bio_kp.symbol_name = "submit_bio";
+    submit_bio_kp.pre_handler = submit_bio_entry_handler;
+    ret = register_kprobe(&submit_bio_kp);
+    if (ret < 0) {
+        printk(KERN_ERR "%s: register_kprobe failed, returned %d\n", MODULE_NAME, ret);
+        goto err_alert;
+    }
+
+    printk(KERN_INFO "%s: bio collector (profile %s), kprobe at %p\n", MODULE_NAME,
+           iomon_profile_names[IOMON_PROFILE], submit_bio_kp.addr);
+    return 0;
+
+err_alert:
+    iomon_alert_exit();
+err_rates:
+    iomon_proc_remove(RATES_PROC_NAME);
+err_stats:
+    iomon_proc_remove(STATS_PROC_NAME);
+err_rule:
+    kernel_param_lock(THIS_MODULE);
+    kfree(rcu_dereference_protected(current_rule, 1));
+    RCU_INIT_POINTER(current_rule, NULL);
+    kernel_param_unlock(THIS_MODULE);
+    return ret;
+}
+
+static void bio_collector_exit(void)
+{
+    struct filter_rule *rule;
+
+    unregister_kprobe(&submit_bio_kp);
+    iomon_alert_exit();
+    iomon_proc_remove(RATES_PROC_NAME);
+    iomon_proc_remove(STATS_PROC_NAME);
+    kernel_param_lock(THIS_MODULE); // 与运行时修改方向开关互斥
+    rule = rcu_dereference_protected(current_rule, 1);
+    RCU_INIT_POINTER(current_rule, NULL);
+    kernel_param_unlock(THIS_MODULE);
+    kfree_rcu(rule, rcu);
+}
+
+const struct iomon_collector iomon_bio_collector = {
+    .name = "bio",
+    .init = bio_collector_init,
+    .exit = bio_collector_exit,
+};
@@ -0,0 +1,71 @@
+// 进程遍历采集器：/proc/iomon/tasks 输出每个进程的内存和 task->ioac 统计，
+// 格式与 module_proc_read 的 /proc/task_io_info 相同
+#include "iomon.h"
+
+#include <linux/sched/signal.h>
+#include <linux/mm.h>
+#include <linux/cred.h>
+
+#define TASKS_PROC_NAME "tasks"
+
+// 采集单个进程详细信息并输出到 seq_file
+static void show_task_info(struct seq_file *m, struct task_struct *task)
+{
+    unsigned long vm_size = 0;     // 虚拟内存大小（字节）
+    unsigned long rss = 0;         // 常驻物理内存（字节）
+    unsigned long read_bytes = 0;  // 累计读取字节数
+    unsigned long write_bytes = 0; // 累计写入字节数
+
+    if (task->mm) { // 内核线程没有 mm
+        vm_size = task->mm->total_vm << PAGE_SHIFT;
+        rss = get_mm_rss(task->mm) << PAGE_SHIFT;
+    }
+
+#ifdef CONFIG_TASK_IO_ACCOUNTING
+    read_bytes = task->ioac.read_bytes;
+    write_bytes = task->ioac.write_bytes;
+#endif
+
+    seq_printf(m,
+        "%-7d %-16s %-7ld %-7d %-7d %-9lu %-9lu %-10lu %-10lu\n",
+        task->pid,
+        task->comm,
+        iomon_task_state(task),
+        task->real_parent ? task->real_parent->pid : 0,
+        __kuid_val(__task_cred(task)->uid),
+        vm_size / 1024,
+        rss / 1024,
+        read_bytes,
+        write_bytes);
+}
+
+static int tasks_show(struct seq_file *m, void *v)
+{
+    struct task_struct *task;
+
+    seq_printf(m, "PID     COMM             STATE   PPID    UID     VM(KB)    RSS(KB)   IO_R      IO_W\n");
+    iomon_seq_rule(m, '-', 79);
+
+    rcu_read_lock(); // for_each_process 和 __task_cred 都需要 RCU 保护
+    for_each_process(task) {
+        show_task_info(m, task);
+    }
+    rcu_read_unlock();
+    return 0;
+}
+
+static int task_collector_init(void)
+{
+    return iomon_proc_create_single(TASKS_PROC_NAME, tasks_show);
+}
+
+static void task_collector_exit(void)
+{
+    iomon_proc_remove(TASKS_PROC_NAME);
+}
+
+const struct iomon_collector iomon_task_collector = {
+    .name = "task",
+    .init = task_collector_init,
+    .exit = task_collector_exit,
+};
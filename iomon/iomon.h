@@ -0,0 +1,299 @@
+#ifndef IOMON_H
+#define IOMON_H
+
+#include <linux/module.h>
+#include <linux/proc_fs.h>
+#include <linux/seq_file.h>
+#include <linux/fs.h>
+#include <linux/sched.h>
+#include <linux/atomic.h>
+#include <linux/percpu.h>
+#include <linux/rcupdate.h>
+#include <linux/rculist.h>
+#include <linux/spinlock.h>
+#include <linux/jiffies.h>
+#include <linux/hash.h>
+#include <linux/pid_namespace.h>
+#include <linux/version.h>
+
+#define MODULE_NAME "iomon"
+
+/* ==================== 版本兼容 ==================== */
+
+// 5.6 起 procfs 使用 proc_ops，6.2 起 del_timer_sync 更名为 timer_delete_sync
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5,6,0)
+#define HAVE_PROC_OPS
+#endif
+#if LINUX_VERSION_CODE < KERNEL_VERSION(6,2,0)
+#define timer_delete_sync del_timer_sync
+#endif
+
+// 定义 procfs 文件操作表，所有 proc 文件都通过它屏蔽 proc_ops / file_operations 的差异，
+// 不需要的回调传 NULL
+#ifdef HAVE_PROC_OPS
+typedef struct proc_ops iomon_proc_ops_t;
+#define IOMON_PROC_OPS(name, open_fn, read_fn, write_fn, poll_fn, lseek_fn, release_fn) \
+static const struct proc_ops name = {                                                  \
+    .proc_open = open_fn,                                                              \
+    .proc_read = read_fn,                                                              \
+    .proc_write = write_fn,                                                            \
+    .proc_poll = poll_fn,                                                              \
+    .proc_lseek = lseek_fn,                                                            \
+    .proc_release = release_fn,                                                        \
+}
+#else
+typedef struct file_operations iomon_proc_ops_t;
+#define IOMON_PROC_OPS(name, open_fn, read_fn, write_fn, poll_fn, lseek_fn, release_fn) \
+static const struct file_operations name = {                                           \
+    .owner = THIS_MODULE,                                                              \
+    .open = open_fn,                                                                   \
+    .read = read_fn,                                                                   \
+    .write = write_fn,                                                                 \
+    .poll = poll_fn,                                                                   \
+    .llseek = lseek_fn,                                                                \
+    .release = release_fn,                                                             \
+}
+#endif
+
+/* ==================== 编译期档位 ==================== */
+
+// 由 Makefile 的 PROFILE=device|process|full 传入：
+//   device  只统计目标设备的总量、速率和设备级告警，bio 处理函数只做设备号比较和本 CPU 计数
+//   process 在 device 基础上增加按进程统计（PID 查找和进程级原子计数）
+//   full    在 process 基础上增加过滤规则中的读/写方向开关（模块参数 track_read / track_write，默认）
+#define IOMON_PROFILE_DEVICE  1
+#define IOMON_PROFILE_PROCESS 2
+#define IOMON_PROFILE_FULL    3
+#ifndef IOMON_PROFILE
+#define IOMON_PROFILE IOMON_PROFILE_FULL
+#endif
+#define IOMON_PER_PROCESS (IOMON_PROFILE >= IOMON_PROFILE_PROCESS)
+#define IOMON_DIR_FILTER  (IOMON_PROFILE >= IOMON_PROFILE_FULL)
+
+/* ==================== 采集器接口 ==================== */
+
+// 每个采集器在 init 中创建自己的 proc 文件、注册钩子，exit 中按相反顺序撤销
+struct iomon_collector {
+    const char *name;
+    int (*init)(void);
+    void (*exit)(void);
+};
+
+extern const struct iomon_collector iomon_task_collector;  // 遍历进程，输出 task->ioac
+extern const struct iomon_collector iomon_fdev_collector;  // 按打开文件所在设备归属进程 IO
+extern const struct iomon_collector iomon_bio_collector;   // kprobe submit_bio 按 bio 记账
+
+// 目标设备名（device 参数，未指定时为 "default"）和解析得到的设备号
+extern char iomon_target_name[];
+extern dev_t iomon_target_dev;
+
+/* ==================== 计数核心 ==================== */
+
+// 滑动窗口速率：按秒分桶的环形计数器，slot = 秒号 & (IOMON_RATE_SLOTS - 1)，
+// stamp 记录桶所属的秒号，写入时发现秒号变化即清零复用，更新为 O(1)
+#define IOMON_RATE_SLOTS 64 // 必须是 2 的幂，且大于最大窗口 60s
+#define IOMON_RATE_NR_WINDOWS 3
+extern const unsigned int iomon_rate_windows[IOMON_RATE_NR_WINDOWS]; // 1s/10s/60s
+
+// 设备级速率桶
+struct iomon_rate_bucket {
+    unsigned long stamp;
+    u64 bytes[2]; // 以 bio_data_dir() 为下标：READ / WRITE
+    u64 ios[2];
+};
+
+// 设备级计数：累计总量和速率桶都是每 CPU 一份，热路径上无需原子操作，读取时求和
+struct iomon_dev_pcpu {
+    u64 bytes[2];
+    u64 ios[2];
+    struct iomon_rate_bucket slot[IOMON_RATE_SLOTS];
+};
+extern struct iomon_dev_pcpu __percpu *iomon_dev_pcpu;
+
+// 进程级速率桶：每进程一份，与累计计数一样使用原子操作。进程条目在 kprobe 中以 GFP_ATOMIC
+// 分配，桶数组占了条目的绝大部分，因此用 32 位紧凑格式：秒号只存低 32 位，
+// 字节数按 512 字节扇区计（bio 长度总是扇区的整数倍），单进程每秒上限 2TiB
+#define IOMON_SECTOR_SHIFT 9
+struct iomon_proc_rate_bucket {
+    atomic_t stamp;
+    atomic_t sectors[2];
+    atomic_t ios[2];
+};
+
+// 各窗口（1s/10s/60s）的累加结果
+struct iomon_rate_sum {
+    u64 bytes[IOMON_RATE_NR_WINDOWS][2];
+    u64 ios[IOMON_RATE_NR_WINDOWS][2];
+};
+
+// 进程级统计结构体。以 (全局 PID, 启动时间) 作为身份：容器密集的主机上 PID 复用很快，
+// 只用 PID 作键会把不同进程的计数并到同一行；同时记录 PID 命名空间和命名空间内的 PID 供输出
+struct iomon_proc_stats {
+    pid_t pid;          // 全局 PID
+    u64 start_time;     // task->start_time，与 pid 一起唯一确定一个任务
+    pid_t ns_pid;       // 所在 PID 命名空间内的 PID
+    unsigned int pidns; // PID 命名空间 inode 号，与 /proc/<pid>/ns/pid 一致
+    char comm[TASK_COMM_LEN];
+    atomic64_t bytes[2]; // 以 bio_data_dir() 为下标：READ / WRITE
+    atomic64_t ios[2];
+    // 以下字段只由告警定时器访问：上一窗口末的累计值和已超限的指标位图
+    u64 win_bytes;
+    u64 win_ios;
+    unsigned int alert_state;
+    unsigned long last_sec; // 最近一次有 IO 的秒号，换桶时更新，用于淘汰空闲条目
+    struct iomon_proc_rate_bucket rate[IOMON_RATE_SLOTS];
+    struct hlist_node hash_node;
+    struct rcu_head rcu;
+};
+
+// 哈希表存储进程统计（键为全局 PID + 启动时间）。条目数受 proc_table_max 参数限制，
+// 表满时新进程的 bio 只计入设备总量；已退出的条目由 iomon_proc_table_gc() 淘汰
+#define IOMON_HASH_BITS 12 // 条目数达到默认上限 8192 时平均链长为 2
+#define IOMON_HASH_SIZE (1 << IOMON_HASH_BITS)
+extern struct hlist_head iomon_proc_table[IOMON_HASH_SIZE];
+
+// 用乘法哈希混合 PID 和启动时间，避免 pid % SIZE 在 PID 连续分配时的聚集
+static inline struct hlist_head *iomon_proc_bucket(pid_t pid, u64 start_time)
+{
+    return &iomon_proc_table[hash_64(((u64)pid << 32) ^ start_time, IOMON_HASH_BITS)];
+}
+
+static inline struct iomon_proc_stats *iomon_proc_stats_find(struct hlist_head *head,
+                                                            pid_t pid, u64 start_time)
+{
+    struct iomon_proc_stats *stats;
+
+    hlist_for_each_entry_rcu(stats, head, hash_node) {
+        if (stats->pid == pid && stats->start_time == start_time)
+            return stats;
+    }
+    return NULL;
+}
+
+struct iomon_proc_stats *iomon_proc_stats_create(struct task_struct *task,
+                                                 struct hlist_head *head);
+void iomon_proc_table_gc(void);
+u64 iomon_proc_untracked(void);
+
+// 获取任务的统计结构（不存在则创建）；查找在热路径上内联，只有新建走函数调用
+static inline struct iomon_proc_stats *iomon_get_proc_stats(struct task_struct *task)
+{
+    pid_t pid = task_pid_nr(task);
+    u64 start_time = task->start_time;
+    struct hlist_head *head = iomon_proc_bucket(pid, start_time);
+    struct iomon_proc_stats *stats;
+
+    rcu_read_lock();
+    stats = iomon_proc_stats_find(head, pid, start_time);
+    rcu_read_unlock();
+    return stats ? stats : iomon_proc_stats_create(task, head);
+}
+
+// 当前秒号
+static inline unsigned long iomon_rate_now(void)
+{
+    return jiffies / HZ;
+}
+
+// 设备级记账：调用方须已关闭抢占（kprobe 处理函数中即是如此），直接写本 CPU 的计数和桶
+static inline void iomon_account_dev(int dir, u64 bytes, unsigned long sec)
+{
+    struct iomon_dev_pcpu *pc = this_cpu_ptr(iomon_dev_pcpu);
+    struct iomon_rate_bucket *b = &pc->slot[sec & (IOMON_RATE_SLOTS - 1)];
+
+    WRITE_ONCE(pc->bytes[dir], pc->bytes[dir] + bytes);
+    WRITE_ONCE(pc->ios[dir], pc->ios[dir] + 1);
+
+    if (b->stamp != sec) {
+        WRITE_ONCE(b->bytes[READ], 0);
+        WRITE_ONCE(b->bytes[WRITE], 0);
+        WRITE_ONCE(b->ios[READ], 0);
+        WRITE_ONCE(b->ios[WRITE], 0);
+        WRITE_ONCE(b->stamp, sec);
+    }
+    WRITE_ONCE(b->bytes[dir], b->bytes[dir] + bytes);
+    WRITE_ONCE(b->ios[dir], b->ios[dir] + 1);
+}
+
+// 进程级记账：抢到换桶权的 CPU 负责清零，并发下最多丢失换秒瞬间的少量计数
+static inline void iomon_account_proc(struct iomon_proc_stats *stats, int dir, u64 bytes,
+                                      unsigned long sec)
+{
+    struct iomon_proc_rate_bucket *b = &stats->rate[sec & (IOMON_RATE_SLOTS - 1)];
+    int old = atomic_read(&b->stamp);
+
+    atomic64_add(bytes, &stats->bytes[dir]);
+    atomic64_inc(&stats->ios[dir]);
+
+    if (old != (int)sec && atomic_cmpxchg(&b->stamp, old, (int)sec) == old) {
+        atomic_set(&b->sectors[READ], 0);
+        atomic_set(&b->sectors[WRITE], 0);
+        atomic_set(&b->ios[READ], 0);
+        atomic_set(&b->ios[WRITE], 0);
+        WRITE_ONCE(stats->last_sec, sec);
+    }
+    atomic_add(bytes >> IOMON_SECTOR_SHIFT, &b->sectors[dir]);
+    atomic_inc(&b->ios[dir]);
+}
+
+void iomon_dev_totals(u64 bytes[2], u64 ios[2]);
+void iomon_rate_sum_dev(struct iomon_rate_sum *sum, unsigned long now);
+void iomon_rate_sum_proc(struct iomon_rate_sum *sum, struct iomon_proc_stats *stats,
+                         unsigned long now);
+
+// 聚合快照：按 PID 排序的紧凑数组，由读者按需重建，且每个周期最多重建一次。
+// 每次重建生成号 gen 加一，changed_gen 记录条目计数最后一次变化时的生成号。
+// 被淘汰的条目记入 removed（按淘汰时的生成号升序，changed_gen 即该生成号），
+// 只保留最近 IOMON_SNAP_REMOVED_MAX 条：生成号不超过 removed_floor 的淘汰记录可能已丢失
+#define IOMON_SNAP_REMOVED_MAX 4096
+struct iomon_snap_entry {
+    pid_t pid;
+    u64 start_time;
+    pid_t ns_pid;
+    unsigned int pidns;
+    char comm[TASK_COMM_LEN];
+    u64 read_bytes;
+    u64 write_bytes;
+    u64 changed_gen;
+};
+
+struct iomon_snapshot {
+    u64 gen;
+    unsigned long built; // 重建时刻（jiffies）
+    u64 total_read;
+    u64 total_write;
+    unsigned int nr;
+    struct iomon_snap_entry *removed; // 与 ent 同一块内存，位于 ent 之后
+    unsigned int nr_removed;
+    u64 removed_floor;
+    struct rcu_head rcu;
+    struct iomon_snap_entry ent[];
+};
+extern struct iomon_snapshot __rcu *iomon_snapshot;
+
+// 快照过期则重建（可能睡眠）。返回后调用方在 rcu_read_lock 下读取 iomon_snapshot
+int iomon_snapshot_update(void);
+
+int iomon_core_init(void);
+void iomon_core_exit(void);
+
+/* ==================== 输出层 ==================== */
+
+// 所有 proc 文件都建在 /proc/iomon/ 目录下
+int iomon_output_init(void);
+void iomon_output_exit(void);
+int iomon_proc_create(const char *name, umode_t mode, const iomon_proc_ops_t *ops);
+int iomon_proc_create_single(const char *name, int (*show)(struct seq_file *, void *));
+void iomon_proc_remove(const char *name);
+
+void iomon_seq_rule(struct seq_file *m, char c, int width);
+void iomon_seq_rates_header(struct seq_file *m);
+void iomon_seq_rates(struct seq_file *m, const struct iomon_rate_sum *sum);
+long iomon_task_state(struct task_struct *task);
+
+/* ==================== 阈值告警 ==================== */
+
+int iomon_alert_init(void);
+void iomon_alert_exit(void);
+
+#endif /* IOMON_H */
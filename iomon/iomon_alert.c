@@ -0,0 +1,321 @@
+// 阈值告警：定时器每个窗口评估一次设备级和进程级 bytes/s、IOPS 阈值，
+// 越限事件写入环形缓冲区，通过 /proc/iomon/events 的 read()/poll() 交给守护进程
+#include "iomon.h"
+
+#include <linux/timer.h>
+#include <linux/wait.h>
+#include <linux/poll.h>
+#include <linux/uaccess.h>
+#include <linux/slab.h>
+
+#define ALERT_PROC_NAME "events"
+
+// 阈值告警参数（0 表示关闭），运行时可通过 /sys/module/iomon/parameters 修改
+static unsigned long dev_bps_limit;
+module_param(dev_bps_limit, ulong, 0644);
+MODULE_PARM_DESC(dev_bps_limit, "Device read+write bytes/s alert threshold (0 = off)");
+static unsigned long dev_iops_limit;
+module_param(dev_iops_limit, ulong, 0644);
+MODULE_PARM_DESC(dev_iops_limit, "Device read+write IOPS alert threshold (0 = off)");
+static unsigned long proc_bps_limit;
+static unsigned long proc_iops_limit;
+#if IOMON_PER_PROCESS
+module_param(proc_bps_limit, ulong, 0644);
+MODULE_PARM_DESC(proc_bps_limit, "Per-process read+write bytes/s alert threshold (0 = off)");
+module_param(proc_iops_limit, ulong, 0644);
+MODULE_PARM_DESC(proc_iops_limit, "Per-process read+write IOPS alert threshold (0 = off)");
+#endif
+static unsigned int alert_window_ms = 1000;
+module_param(alert_window_ms, uint, 0644);
+MODULE_PARM_DESC(alert_window_ms, "Threshold evaluation window in milliseconds");
+
+// 告警指标
+enum alert_metric {
+    ALERT_BPS,
+    ALERT_IOPS,
+};
+static const char * const alert_metric_names[] = {
+    [ALERT_BPS] = "bps",
+    [ALERT_IOPS] = "iops",
+};
+
+// 一条告警事件：pid 为 0 表示设备级告警
+struct io_alert {
+    u64 ts_ns;
+    dev_t dev;
+    pid_t pid;
+    pid_t ns_pid;
+    char comm[TASK_COMM_LEN];
+    enum alert_metric metric;
+    u64 value;
+    u64 limit;
+};
+
+// 告警环形缓冲区：alert_head 为下一条事件的序号，读者各自保存读游标，
+// 落后超过 ALERT_RING_SIZE 的读者会跳过被覆盖的旧事件
+#define ALERT_RING_SIZE 64 // 必须是 2 的幂
+static struct io_alert alert_ring[ALERT_RING_SIZE];
+static u64 alert_head;
+static DEFINE_SPINLOCK(alert_lock);
+static DECLARE_WAIT_QUEUE_HEAD(alert_wq);
+static bool alert_shutdown; // 卸载时置位，唤醒阻塞的读者，避免 remove_proc_entry 一直等待
+
+// 告警定时器及设备级窗口状态
+static struct timer_list alert_timer;
+static unsigned long alert_last_jiffies;
+static u64 dev_win_bytes, dev_win_ios;
+static unsigned int dev_alert_state;
+
+// 记录一条告警（定时器上下文调用）
+static void push_alert(dev_t dev, pid_t pid, pid_t ns_pid, const char *comm,
+                       enum alert_metric metric, u64 value, u64 limit)
+{
+    struct io_alert *a;
+
+    spin_lock(&alert_lock);
+    a = &alert_ring[alert_head & (ALERT_RING_SIZE - 1)];
+    a->ts_ns = ktime_get_real_ns();
+    a->dev = dev;
+    a->pid = pid;
+    a->ns_pid = ns_pid;
+    strscpy(a->comm, comm, TASK_COMM_LEN);
+    a->metric = metric;
+    a->value = value;
+    a->limit = limit;
+    alert_head++;
+    spin_unlock(&alert_lock);
+}
+
+// 只在指标由未超限变为超限时上报一次，回落后重新武装
+static bool check_metric(unsigned int *state, enum alert_metric metric,
+                         u64 value, u64 limit)
+{
+    bool over = limit && value > limit;
+    bool crossed = over && !(*state & BIT(metric));
+
+    if (over)
+        *state |= BIT(metric);
+    else
+        *state &= ~BIT(metric);
+    return crossed;
+}
+
+// 窗口内增量换算为每秒速率
+static u64 window_rate(u64 delta, unsigned int ms)
+{
+    return ms ? div_u64(delta * MSEC_PER_SEC, ms) : 0;
+}
+
+// 检查设备级阈值，返回是否产生了新告警
+static bool check_dev_thresholds(dev_t dev, unsigned int ms)
+{
+    u64 dir_bytes[2], dir_ios[2], bytes, ios, bps, iops;
+    unsigned long bps_limit = READ_ONCE(dev_bps_limit);
+    unsigned long iops_limit = READ_ONCE(dev_iops_limit);
+    bool fired = false;
+
+    iomon_dev_totals(dir_bytes, dir_ios);
+    bytes = dir_bytes[READ] + dir_bytes[WRITE];
+    ios = dir_ios[READ] + dir_ios[WRITE];
+    bps = window_rate(bytes - dev_win_bytes, ms);
+    iops = window_rate(ios - dev_win_ios, ms);
+    dev_win_bytes = bytes;
+    dev_win_ios = ios;
+
+    if (check_metric(&dev_alert_state, ALERT_BPS, bps, bps_limit)) {
+        push_alert(dev, 0, 0, "-", ALERT_BPS, bps, bps_limit);
+        fired = true;
+    }
+    if (check_metric(&dev_alert_state, ALERT_IOPS, iops, iops_limit)) {
+        push_alert(dev, 0, 0, "-", ALERT_IOPS, iops, iops_limit);
+        fired = true;
+    }
+    return fired;
+}
+
+// 检查进程级阈值：遍历哈希表，比较每个进程本窗口的增量。
+// 阈值为 0 时也要推进窗口末累计值：阈值可在运行时打开，否则首个窗口会把整个生命周期的
+// 累计量当作一个窗口的增量；check_metric() 对为 0 的阈值只清除超限位，不产生告警
+static bool check_proc_thresholds(dev_t dev, unsigned int ms)
+{
+    unsigned long bps_limit = READ_ONCE(proc_bps_limit);
+    unsigned long iops_limit = READ_ONCE(proc_iops_limit);
+    struct iomon_proc_stats *stats;
+    bool fired = false;
+    int i;
+
+    if (!IOMON_PER_PROCESS)
+        return false;
+
+    rcu_read_lock();
+    for (i = 0; i < IOMON_HASH_SIZE; i++) {
+        hlist_for_each_entry_rcu(stats, &iomon_proc_table[i], hash_node) {
+            u64 bytes = atomic64_read(&stats->bytes[READ]) + atomic64_read(&stats->bytes[WRITE]);
+            u64 ios = atomic64_read(&stats->ios[READ]) + atomic64_read(&stats->ios[WRITE]);
+            u64 bps = window_rate(bytes - stats->win_bytes, ms);
+            u64 iops = window_rate(ios - stats->win_ios, ms);
+
+            stats->win_bytes = bytes;
+            stats->win_ios = ios;
+
+            if (check_metric(&stats->alert_state, ALERT_BPS, bps, bps_limit)) {
+                push_alert(dev, stats->pid, stats->ns_pid, stats->comm, ALERT_BPS, bps, bps_limit);
+                fired = true;
+            }
+            if (check_metric(&stats->alert_state, ALERT_IOPS, iops, iops_limit)) {
+                push_alert(dev, stats->pid, stats->ns_pid, stats->comm, ALERT_IOPS, iops, iops_limit);
+                fired = true;
+            }
+        }
+    }
+    rcu_read_unlock();
+    return fired;
+}
+
+// 告警定时器：每个窗口评估一次阈值，有新事件时唤醒 poll()/read() 的等待者；
+// 同时淘汰进程表中已退出或空闲的条目
+static void alert_timer_fn(struct timer_list *t)
+{
+    unsigned int window = READ_ONCE(alert_window_ms) ?: 1000;
+    unsigned int elapsed = jiffies_to_msecs(jiffies - alert_last_jiffies);
+    bool fired;
+
+    alert_last_jiffies = jiffies;
+    fired = check_dev_thresholds(iomon_target_dev, elapsed);
+    fired |= check_proc_thresholds(iomon_target_dev, elapsed);
+    if (fired)
+        wake_up_interruptible(&alert_wq);
+    if (IOMON_PER_PROCESS)
+        iomon_proc_table_gc();
+
+    mod_timer(&alert_timer, jiffies + msecs_to_jiffies(window));
+}
+
+// 读者游标之后是否还有未读事件
+static bool alert_pending(u64 *cursor)
+{
+    bool pending;
+
+    spin_lock_bh(&alert_lock);
+    pending = *cursor < alert_head;
+    spin_unlock_bh(&alert_lock);
+    return pending;
+}
+
+// 读者游标之后是否还有未读事件，或模块正在卸载
+static bool alert_ready(u64 *cursor)
+{
+    return alert_pending(cursor) || READ_ONCE(alert_shutdown);
+}
+
+// 事件文件：每个打开者从打开时刻起接收新事件
+static int alert_open(struct inode *inode, struct file *file)
+{
+    u64 *cursor = kmalloc(sizeof(*cursor), GFP_KERNEL);
+
+    if (!cursor)
+        return -ENOMEM;
+    spin_lock_bh(&alert_lock);
+    *cursor = alert_head;
+    spin_unlock_bh(&alert_lock);
+    file->private_data = cursor;
+    return 0;
+}
+
+static int alert_release(struct inode *inode, struct file *file)
+{
+    kfree(file->private_data);
+    return 0;
+}
+
+// 每次读取返回若干完整的事件行，格式：
+// <时间戳ns> <dev|pid> <主:次设备号|全局PID> <-|命名空间内PID> <comm> <指标> <当前值> <阈值>
+static ssize_t alert_read(struct file *file, char __user *buf, size_t count, loff_t *ppos)
+{
+    u64 *cursor = file->private_data;
+    char line[128];
+    size_t done = 0;
+    int ret;
+
+    if (!(file->f_flags & O_NONBLOCK)) {
+        ret = wait_event_interruptible(alert_wq, alert_ready(cursor));
+        if (ret)
+            return ret;
+    }
+
+    while (done < count) {
+        struct io_alert a;
+        int len;
+
+        spin_lock_bh(&alert_lock);
+        if (*cursor >= alert_head) {
+            spin_unlock_bh(&alert_lock);
+            break;
+        }
+        if (alert_head - *cursor > ALERT_RING_SIZE)
+            *cursor = alert_head - ALERT_RING_SIZE; // 被覆盖的事件直接跳过
+        a = alert_ring[*cursor & (ALERT_RING_SIZE - 1)];
+        spin_unlock_bh(&alert_lock);
+
+        if (a.pid)
+            len = scnprintf(line, sizeof(line), "%llu pid %d %d %s %s %llu %llu\n",
+                            a.ts_ns, a.pid, a.ns_pid, a.comm, alert_metric_names[a.metric],
+                            a.value, a.limit);
+        else
+            len = scnprintf(line, sizeof(line), "%llu dev %d:%d - - %s %llu %llu\n",
+                            a.ts_ns, MAJOR(a.dev), MINOR(a.dev),
+                            alert_metric_names[a.metric], a.value, a.limit);
+
+        if (len > count - done) {
+            if (!done)
+                return -EINVAL; // 用户缓冲区放不下一整行
+            break;
+        }
+        if (copy_to_user(buf + done, line, len))
+            return done ? done : -EFAULT;
+        done += len;
+        (*cursor)++;
+    }
+
+    if (!done)
+        return READ_ONCE(alert_shutdown) ? 0 : -EAGAIN;
+    return done;
+}
+
+static __poll_t alert_poll(struct file *file, poll_table *wait)
+{
+    __poll_t mask = 0;
+
+    poll_wait(file, &alert_wq, wait);
+    if (alert_pending(file->private_data))
+        mask |= EPOLLIN | EPOLLRDNORM;
+    if (READ_ONCE(alert_shutdown))
+        mask |= EPOLLHUP;
+    return mask;
+}
+
+IOMON_PROC_OPS(alert_fops, alert_open, alert_read, NULL, alert_poll, noop_llseek, alert_release);
+
+int iomon_alert_init(void)
+{
+    int ret;
+
+    // 创建 /proc/iomon/events，守护进程可在其上 poll() 等待阈值告警
+    ret = iomon_proc_create(ALERT_PROC_NAME, 0444, &alert_fops);
+    if (ret)
+        return ret;
+
+    // 启动阈值评估定时器
+    timer_setup(&alert_timer, alert_timer_fn, 0);
+    alert_last_jiffies = jiffies;
+    mod_timer(&alert_timer, jiffies + msecs_to_jiffies(alert_window_ms ?: 1000));
+    return 0;
+}
+
+void iomon_alert_exit(void)
+{
+    WRITE_ONCE(alert_shutdown, true);
+    wake_up_all(&alert_wq);
+    timer_delete_sync(&alert_timer);
+    iomon_proc_remove(ALERT_PROC_NAME);
+}
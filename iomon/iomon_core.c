@@ -0,0 +1,370 @@
+// 计数核心：设备级每 CPU 计数、进程级哈希表、滑动窗口速率和聚合快照，
+// 由 bio 采集器写入，由输出层和告警读取
+#include "iomon.h"
+
+#include <linux/slab.h>
+#include <linux/mm.h>
+#include <linux/mutex.h>
+#include <linux/sort.h>
+
+static unsigned int snapshot_interval_ms = 1000;
+module_param(snapshot_interval_ms, uint, 0644);
+MODULE_PARM_DESC(snapshot_interval_ms, "Minimum interval between /proc/iomon/stats snapshot rebuilds in milliseconds (0 = every read)");
+
+static unsigned int proc_table_max = 8192;
+module_param(proc_table_max, uint, 0644);
+MODULE_PARM_DESC(proc_table_max, "Maximum number of per-process entries; bios of further processes only count towards the device totals");
+
+const unsigned int iomon_rate_windows[IOMON_RATE_NR_WINDOWS] = { 1, 10, 60 };
+
+struct iomon_dev_pcpu __percpu *iomon_dev_pcpu;
+struct hlist_head iomon_proc_table[IOMON_HASH_SIZE];
+static DEFINE_SPINLOCK(proc_table_lock); // 保护哈希表插入和删除
+static atomic_t proc_count;                // 表中条目数
+static atomic64_t proc_untracked;          // 表满或分配失败时未能按进程记账的 bio 数
+
+struct iomon_snapshot __rcu *iomon_snapshot;
+static DEFINE_MUTEX(snapshot_mutex); // 串行化重建
+
+// 新建任务统计条目（kzalloc 同时清零计数和速率桶）。
+// 加锁后再查一次，两个 CPU 同时为同一任务建条目时只保留先插入的那个
+struct iomon_proc_stats *iomon_proc_stats_create(struct task_struct *task,
+                                                 struct hlist_head *head)
+{
+    struct iomon_proc_stats *stats;
+    struct iomon_proc_stats *found;
+    struct pid_namespace *ns;
+    unsigned long flags;
+
+    if (atomic_inc_return(&proc_count) > READ_ONCE(proc_table_max)) {
+        atomic_dec(&proc_count);
+        atomic64_inc(&proc_untracked);
+        return NULL;
+    }
+    stats = kzalloc(sizeof(*stats), GFP_ATOMIC);
+    if (!stats) {
+        atomic_dec(&proc_count);
+        atomic64_inc(&proc_untracked);
+        return NULL;
+    }
+
+    rcu_read_lock();
+    ns = task_active_pid_ns(task);
+    stats->pid = task_pid_nr(task);
+    stats->start_time = task->start_time;
+    stats->ns_pid = ns ? task_pid_nr_ns(task, ns) : stats->pid;
+    stats->pidns = ns ? ns->ns.inum : 0;
+    rcu_read_unlock();
+    get_task_comm(stats->comm, task);
+    stats->last_sec = iomon_rate_now();
+
+    // kprobe 可能在任意上下文触发，淘汰在定时器软中断中进行，因此关中断加锁
+    spin_lock_irqsave(&proc_table_lock, flags);
+    found = iomon_proc_stats_find(head, stats->pid, stats->start_time);
+    if (!found)
+        hlist_add_head_rcu(&stats->hash_node, head);
+    spin_unlock_irqrestore(&proc_table_lock, flags);
+
+    if (found) {
+        atomic_dec(&proc_count);
+        kfree(stats);
+        return found;
+    }
+    return stats;
+}
+
+// 条目对应的任务是否已退出（PID 已释放或被新任务复用）。调用方持有 rcu_read_lock
+static bool proc_stats_exited(struct iomon_proc_stats *stats)
+{
+    struct task_struct *task = pid_task(find_pid_ns(stats->pid, &init_pid_ns), PIDTYPE_PID);
+
+    return !task || task->start_time != stats->start_time;
+}
+
+// 淘汰任务已退出、且超过最大窗口（60s）没有 IO 的条目，让速率和告警仍能看到刚退出的进程。
+// 仍在运行的任务从不淘汰，它的累计计数不会被重置；表满时新进程只计入设备总量。
+// 由告警定时器周期调用；只有这里删除条目，遍历时无需担心其他删除者
+void iomon_proc_table_gc(void)
+{
+    unsigned long now = iomon_rate_now();
+    unsigned long idle = iomon_rate_windows[IOMON_RATE_NR_WINDOWS - 1];
+    struct iomon_proc_stats *stats;
+    unsigned long flags;
+    int i;
+
+    rcu_read_lock();
+    for (i = 0; i < IOMON_HASH_SIZE; i++) {
+        hlist_for_each_entry_rcu(stats, &iomon_proc_table[i], hash_node) {
+            if (now - READ_ONCE(stats->last_sec) <= idle)
+                continue;
+            if (!proc_stats_exited(stats))
+                continue;
+
+            spin_lock_irqsave(&proc_table_lock, flags);
+            hlist_del_rcu(&stats->hash_node);
+            spin_unlock_irqrestore(&proc_table_lock, flags);
+            atomic_dec(&proc_count);
+            kfree_rcu(stats, rcu);
+        }
+    }
+    rcu_read_unlock();
+}
+
+u64 iomon_proc_untracked(void)
+{
+    return atomic64_read(&proc_untracked);
+}
+
+// 汇总各 CPU 的设备累计计数
+void iomon_dev_totals(u64 bytes[2], u64 ios[2])
+{
+    int cpu;
+
+    bytes[READ] = bytes[WRITE] = ios[READ] = ios[WRITE] = 0;
+    for_each_possible_cpu(cpu) {
+        struct iomon_dev_pcpu *pc = per_cpu_ptr(iomon_dev_pcpu, cpu);
+
+        bytes[READ] += READ_ONCE(pc->bytes[READ]);
+        bytes[WRITE] += READ_ONCE(pc->bytes[WRITE]);
+        ios[READ] += READ_ONCE(pc->ios[READ]);
+        ios[WRITE] += READ_ONCE(pc->ios[WRITE]);
+    }
+}
+
+// 把一个桶累加到所有覆盖它的窗口中；只统计已结束的秒（age >= 1）
+static void rate_sum_add(struct iomon_rate_sum *sum, unsigned long now, unsigned long stamp,
+                         const u64 bytes[2], const u64 ios[2])
+{
+    unsigned long age = now - stamp;
+    int w;
+
+    for (w = 0; w < IOMON_RATE_NR_WINDOWS; w++) {
+        if (age < 1 || age > iomon_rate_windows[w])
+            continue;
+        sum->bytes[w][READ] += bytes[READ];
+        sum->bytes[w][WRITE] += bytes[WRITE];
+        sum->ios[w][READ] += ios[READ];
+        sum->ios[w][WRITE] += ios[WRITE];
+    }
+}
+
+void iomon_rate_sum_dev(struct iomon_rate_sum *sum, unsigned long now)
+{
+    int cpu, i;
+
+    memset(sum, 0, sizeof(*sum));
+    for_each_possible_cpu(cpu) {
+        struct iomon_dev_pcpu *pc = per_cpu_ptr(iomon_dev_pcpu, cpu);
+
+        for (i = 0; i < IOMON_RATE_SLOTS; i++) {
+            const struct iomon_rate_bucket *b = &pc->slot[i];
+            u64 bytes[2] = { READ_ONCE(b->bytes[READ]), READ_ONCE(b->bytes[WRITE]) };
+            u64 ios[2] = { READ_ONCE(b->ios[READ]), READ_ONCE(b->ios[WRITE]) };
+
+            rate_sum_add(sum, now, READ_ONCE(b->stamp), bytes, ios);
+        }
+    }
+}
+
+void iomon_rate_sum_proc(struct iomon_rate_sum *sum, struct iomon_proc_stats *stats,
+                         unsigned long now)
+{
+    int i;
+
+    memset(sum, 0, sizeof(*sum));
+    for (i = 0; i < IOMON_RATE_SLOTS; i++) {
+        struct iomon_proc_rate_bucket *b = &stats->rate[i];
+        u64 bytes[2] = { (u64)(u32)atomic_read(&b->sectors[READ]) << IOMON_SECTOR_SHIFT,
+                         (u64)(u32)atomic_read(&b->sectors[WRITE]) << IOMON_SECTOR_SHIFT };
+        u64 ios[2] = { (u32)atomic_read(&b->ios[READ]), (u32)atomic_read(&b->ios[WRITE]) };
+        // 桶里只有秒号低 32 位，按与 now 的差值还原
+        unsigned long stamp = now - (u32)((u32)now - (u32)atomic_read(&b->stamp));
+
+        rate_sum_add(sum, now, stamp, bytes, ios);
+    }
+}
+
+// 快照是否仍在有效期内
+static bool snapshot_fresh(struct iomon_snapshot *snap)
+{
+    return snap && time_before(jiffies, snap->built +
+                               msecs_to_jiffies(READ_ONCE(snapshot_interval_ms)));
+}
+
+static int snap_entry_cmp(const void *a, const void *b)
+{
+    const struct iomon_snap_entry *x = a, *y = b;
+
+    if (x->pid != y->pid)
+        return (x->pid > y->pid) - (x->pid < y->pid);
+    return (x->start_time > y->start_time) - (x->start_time < y->start_time);
+}
+
+// 记录一条被淘汰的条目，changed_gen 改为发现它消失的生成号
+static void snap_removed_add(struct iomon_snapshot *snap, const struct iomon_snap_entry *e)
+{
+    struct iomon_snap_entry *r = &snap->removed[snap->nr_removed++];
+
+    *r = *e;
+    r->changed_gen = snap->gen;
+}
+
+// 重建快照：遍历哈希表拷贝计数，按 PID 排序，再与旧快照归并得出 changed_gen；
+// 旧快照中有而新快照中没有的条目（已被淘汰）追加到 removed 列表
+static int snapshot_refresh(void)
+{
+    struct iomon_snapshot *old, *snap;
+    struct iomon_proc_stats *stats;
+    unsigned int cap, removed_cap, nr = 0, i, j;
+    u64 bytes[2], ios[2];
+    int ret = 0;
+
+    mutex_lock(&snapshot_mutex);
+    old = rcu_dereference_protected(iomon_snapshot, lockdep_is_held(&snapshot_mutex));
+    if (snapshot_fresh(old))
+        goto out; // 等锁期间已被其他读者重建
+
+    // 淘汰记录放在条目数组之后：最多是旧快照的记录加上旧快照的全部条目
+    removed_cap = old ? old->nr_removed + old->nr : 0;
+
+    // 数组装满说明拷贝期间新增的进程超过了余量，可能漏掉条目：放弃这一份，重新计数再拷贝
+    for (;;) {
+        cap = nr + 64; // 上一轮数到的条目数，加上为拷贝期间新增进程留的余量
+        nr = 0;
+        snap = kvmalloc(struct_size(snap, ent, cap + removed_cap), GFP_KERNEL);
+        if (!snap) {
+            ret = -ENOMEM;
+            goto out;
+        }
+
+        iomon_dev_totals(bytes, ios);
+        snap->total_read = bytes[READ];
+        snap->total_write = bytes[WRITE];
+
+        rcu_read_lock();
+        for (i = 0; i < IOMON_HASH_SIZE; i++) {
+            hlist_for_each_entry_rcu(stats, &iomon_proc_table[i], hash_node) {
+                struct iomon_snap_entry *e;
+
+                if (nr == cap) {
+                    nr++; // 只计数，不再拷贝
+                    continue;
+                }
+                e = &snap->ent[nr++];
+                e->pid = stats->pid;
+                e->start_time = stats->start_time;
+                e->ns_pid = stats->ns_pid;
+                e->pidns = stats->pidns;
+                memcpy(e->comm, stats->comm, TASK_COMM_LEN);
+                e->read_bytes = atomic64_read(&stats->bytes[READ]);
+                e->write_bytes = atomic64_read(&stats->bytes[WRITE]);
+            }
+        }
+        rcu_read_unlock();
+
+        if (nr < cap)
+            break;
+        kvfree(snap);
+    }
+
+    sort(snap->ent, nr, sizeof(snap->ent[0]), snap_entry_cmp, NULL);
+
+    snap->gen = old ? old->gen + 1 : 1;
+    snap->removed = snap->ent + cap;
+    snap->nr_removed = 0;
+    snap->removed_floor = old ? old->removed_floor : 0;
+    if (old) {
+        memcpy(snap->removed, old->removed, old->nr_removed * sizeof(old->removed[0]));
+        snap->nr_removed = old->nr_removed;
+    }
+
+    for (i = 0, j = 0; i < nr; i++) {
+        struct iomon_snap_entry *e = &snap->ent[i];
+
+        e->changed_gen = snap->gen;
+        if (!old)
+            continue;
+        while (j < old->nr && snap_entry_cmp(&old->ent[j], e) < 0)
+            snap_removed_add(snap, &old->ent[j++]);
+        if (j < old->nr && snap_entry_cmp(&old->ent[j], e) == 0) {
+            if (old->ent[j].read_bytes == e->read_bytes &&
+                old->ent[j].write_bytes == e->write_bytes)
+                e->changed_gen = old->ent[j].changed_gen;
+            j++;
+        }
+    }
+    while (old && j < old->nr)
+        snap_removed_add(snap, &old->ent[j++]);
+    snap->nr = nr;
+
+    // 只保留最近 IOMON_SNAP_REMOVED_MAX 条淘汰记录，丢弃的最新一条的生成号成为新的下界
+    if (snap->nr_removed > IOMON_SNAP_REMOVED_MAX) {
+        unsigned int drop = snap->nr_removed - IOMON_SNAP_REMOVED_MAX;
+
+        snap->removed_floor = snap->removed[drop - 1].changed_gen;
+        memmove(snap->removed, snap->removed + drop,
+                IOMON_SNAP_REMOVED_MAX * sizeof(snap->removed[0]));
+        snap->nr_removed = IOMON_SNAP_REMOVED_MAX;
+    }
+    snap->built = jiffies;
+
+    rcu_assign_pointer(iomon_snapshot, snap);
+    if (old)
+        kvfree_rcu(old, rcu);
+out:
+    mutex_unlock(&snapshot_mutex);
+    return ret;
+}
+
+// 快照过期则重建；重建失败但仍有旧快照时继续使用旧快照
+int iomon_snapshot_update(void)
+{
+    struct iomon_snapshot *snap;
+    bool fresh;
+    int ret;
+
+    rcu_read_lock();
+    snap = rcu_dereference(iomon_snapshot);
+    fresh = snapshot_fresh(snap);
+    rcu_read_unlock();
+    if (fresh)
+        return 0;
+
+    ret = snapshot_refresh();
+    if (ret && rcu_access_pointer(iomon_snapshot))
+        return 0;
+    return ret;
+}
+
+int iomon_core_init(void)
+{
+    int i;
+
+    for (i = 0; i < IOMON_HASH_SIZE; i++)
+        INIT_HLIST_HEAD(&iomon_proc_table[i]);
+
+    iomon_dev_pcpu = alloc_percpu(struct iomon_dev_pcpu);
+    if (!iomon_dev_pcpu)
+        return -ENOMEM;
+    return 0;
+}
+
+// 调用时所有采集器已退出，不再有写者和读者
+void iomon_core_exit(void)
+{
+    struct iomon_proc_stats *stats;
+    struct hlist_node *tmp;
+    int i;
+
+    for (i = 0; i < IOMON_HASH_SIZE; i++) {
+        hlist_for_each_entry_safe(stats, tmp, &iomon_proc_table[i], hash_node) {
+            hlist_del_rcu(&stats->hash_node);
+            kfree_rcu(stats, rcu);
+        }
+    }
+    atomic_set(&proc_count, 0);
+
+    kvfree(rcu_dereference_protected(iomon_snapshot, 1));
+    RCU_INIT_POINTER(iomon_snapshot, NULL);
+    free_percpu(iomon_dev_pcpu);
+}
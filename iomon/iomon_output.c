@@ -0,0 +1,82 @@
+// 输出层：/proc/iomon/ 目录管理和各采集器共用的格式化函数
+#include "iomon.h"
+
+static struct proc_dir_entry *iomon_proc_dir;
+
+int iomon_output_init(void)
+{
+    iomon_proc_dir = proc_mkdir(MODULE_NAME, NULL);
+    return iomon_proc_dir ? 0 : -ENOMEM;
+}
+
+void iomon_output_exit(void)
+{
+    remove_proc_subtree(MODULE_NAME, NULL);
+    iomon_proc_dir = NULL;
+}
+
+int iomon_proc_create(const char *name, umode_t mode, const iomon_proc_ops_t *ops)
+{
+    return proc_create(name, mode, iomon_proc_dir, ops) ? 0 : -ENOMEM;
+}
+
+int iomon_proc_create_single(const char *name, int (*show)(struct seq_file *, void *))
+{
+    return proc_create_single(name, 0444, iomon_proc_dir, show) ? 0 : -ENOMEM;
+}
+
+void iomon_proc_remove(const char *name)
+{
+    remove_proc_entry(name, iomon_proc_dir);
+}
+
+// 输出一行由字符 c 组成、宽度为 width 的分隔线
+void iomon_seq_rule(struct seq_file *m, char c, int width)
+{
+    while (width-- > 0)
+        seq_putc(m, c);
+    seq_putc(m, '\n');
+}
+
+// 速率表头：每个窗口依次为 读B/s 写B/s 读IOPS 写IOPS，与 iomon_seq_rates 列宽一致
+void iomon_seq_rates_header(struct seq_file *m)
+{
+    int w;
+
+    for (w = 0; w < IOMON_RATE_NR_WINDOWS; w++) {
+        char rb[16], wb[16], ri[16], wi[16];
+
+        snprintf(rb, sizeof(rb), "R_BPS/%us", iomon_rate_windows[w]);
+        snprintf(wb, sizeof(wb), "W_BPS/%us", iomon_rate_windows[w]);
+        snprintf(ri, sizeof(ri), "R_IOPS/%us", iomon_rate_windows[w]);
+        snprintf(wi, sizeof(wi), "W_IOPS/%us", iomon_rate_windows[w]);
+        seq_printf(m, " %-12s %-12s %-8s %-8s", rb, wb, ri, wi);
+    }
+    seq_putc(m, '\n');
+}
+
+void iomon_seq_rates(struct seq_file *m, const struct iomon_rate_sum *sum)
+{
+    int w;
+
+    for (w = 0; w < IOMON_RATE_NR_WINDOWS; w++) {
+        unsigned int secs = iomon_rate_windows[w];
+
+        seq_printf(m, " %-12llu %-12llu %-8llu %-8llu",
+                   div_u64(sum->bytes[w][READ], secs),
+                   div_u64(sum->bytes[w][WRITE], secs),
+                   div_u64(sum->ios[w][READ], secs),
+                   div_u64(sum->ios[w][WRITE], secs));
+    }
+    seq_putc(m, '\n');
+}
+
+// 获取进程状态（兼容不同内核版本）
+long iomon_task_state(struct task_struct *task)
+{
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5,14,0)
+    return READ_ONCE(task->__state);
+#else
+    return task->state;
+#endif
+}
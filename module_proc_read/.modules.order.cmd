@@ -1 +0,0 @@
-savedcmd_/home/zly/桌面/ZTE_OS/IO-monitor/module_proc_read/modules.order := {   echo /home/zly/桌面/ZTE_OS/IO-monitor/module_proc_read/task_IO_read.o; :; } > /home/zly/桌面/ZTE_OS/IO-monitor/module_proc_read/modules.order
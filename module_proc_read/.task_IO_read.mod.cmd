@@ -1 +0,0 @@
-savedcmd_/home/zly/桌面/ZTE_OS/IO-monitor/module_proc_read/task_IO_read.mod := printf '%s\n'   task_IO_read.o | awk '!x[$$0]++ { print("/home/zly/桌面/ZTE_OS/IO-monitor/module_proc_read/"$$0) }' > /home/zly/桌面/ZTE_OS/IO-monitor/module_proc_read/task_IO_read.mod
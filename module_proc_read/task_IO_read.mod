@@ -1 +0,0 @@
-/home/zly/桌面/ZTE_OS/IO-monitor/module_proc_read/task_IO_read.o
@@ -0,0 +1,87 @@
+#!/bin/bash
+# 用法：bench_iomon.sh <块设备|nullb> <读取次数> <iomon-*.ko>...
+#
+# 对每个配置（先测不加载模块的基线）：
+#   1. 用 dd 以 4KiB 直接 IO 读取设备 <读取次数> 次，重复 REPEAT 次（默认 5），取每次 IO 平均耗时的最小值
+#   2. 读取 /proc/iomon 下各文件，记录耗时
+# 设备为 nullb 时创建一个 null_blk 设备（不接后端存储、IO 立即完成），每次 IO 只有一两微秒，
+# 各档位处理函数几十纳秒的差异才不会被磁盘延迟淹没。
+# 设置 REAL_DEVICE=/dev/sdX 时，再以该磁盘为统计目标完整测一遍，只作参考。
+# 设备只读不写；读取使用 iflag=direct 绕过页缓存，保证每次读取都经过 submit_bio。
+set -e
+
+if [ $# -lt 3 ]; then
+    echo "usage: $0 <device|nullb> <count> <module.ko>..." >&2
+    exit 1
+fi
+
+DEVICE=$1
+COUNT=$2
+shift 2
+REPEAT=${REPEAT:-5}
+REAL_DEVICE=${REAL_DEVICE:-}
+
+if [ "$DEVICE" = nullb ]; then
+    rmmod null_blk 2>/dev/null || true
+    # irqmode=0 在提交路径上直接完成，queue_mode=2 走 blk-mq；16GiB 容量足够 dd 顺序读取
+    modprobe null_blk nr_devices=1 queue_mode=2 irqmode=0 completion_nsec=0 bs=4096 gb=16
+    trap 'rmmod iomon 2>/dev/null; rmmod null_blk 2>/dev/null' EXIT
+    DEVICE=/dev/nullb0
+    udevadm settle 2>/dev/null || sleep 1
+fi
+
+now_ns() {
+    date +%s%N
+}
+
+# 直接 IO 读取，输出 REPEAT 次中每次 IO 平均耗时的最小值（纳秒）
+bench_io() {
+    local dev=$1 t0 t1 ns best=
+    for _ in $(seq "$REPEAT"); do
+        t0=$(now_ns)
+        dd if="$dev" of=/dev/null bs=4k count="$COUNT" iflag=direct status=none
+        t1=$(now_ns)
+        ns=$(( (t1 - t0) / COUNT ))
+        if [ -z "$best" ] || [ "$ns" -lt "$best" ]; then
+            best=$ns
+        fi
+    done
+    echo "$best"
+}
+
+# 读取一个 proc 文件，输出耗时（微秒）；文件不存在（采集器未编入）时返回 cat 的失败状态
+bench_read() {
+    local t0 t1
+    t0=$(now_ns)
+    cat "$1" > /dev/null || return
+    t1=$(now_ns)
+    echo $(( (t1 - t0) / 1000 ))
+}
+
+# 在一个设备上测一遍基线和每个配置，模块统计的就是该设备
+bench_pass() {
+    local dev=$1 ko ns stats rates tasks
+
+    echo "device: $dev, $COUNT reads x $REPEAT runs"
+    printf "%-24s %-12s %-12s %-12s %-12s\n" "CONFIG" "NS/IO" "STATS(us)" "RATES(us)" "TASKS(us)"
+
+    rmmod iomon 2>/dev/null || true
+    printf "%-24s %-12s %-12s %-12s %-12s\n" "baseline" "$(bench_io "$dev")" "-" "-" "-"
+
+    for ko in "${MODULES[@]}"; do
+        insmod "$ko" device="$dev"
+        ns=$(bench_io "$dev")
+        stats=$(bench_read /proc/iomon/stats 2>/dev/null || echo -)
+        rates=$(bench_read /proc/iomon/rates 2>/dev/null || echo -)
+        tasks=$(bench_read /proc/iomon/tasks 2>/dev/null || echo -)
+        rmmod iomon
+        printf "%-24s %-12s %-12s %-12s %-12s\n" "$(basename "$ko" .ko)" "$ns" "$stats" "$rates" "$tasks"
+    done
+}
+
+MODULES=("$@")
+bench_pass "$DEVICE"
+if [ -n "$REAL_DEVICE" ]; then
+    echo
+    bench_pass "$REAL_DEVICE"
+fi
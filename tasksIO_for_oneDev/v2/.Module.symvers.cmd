@@ -1 +0,0 @@
-savedcmd_/home/zly/桌面/ZTE_OS/IO-monitor/tasksIO_for_oneDev/v2/Module.symvers :=  scripts/mod/modpost -M -m -a      -o /home/zly/桌面/ZTE_OS/IO-monitor/tasksIO_for_oneDev/v2/Module.symvers -T /home/zly/桌面/ZTE_OS/IO-monitor/tasksIO_for_oneDev/v2/modules.order -i Module.symvers -e 
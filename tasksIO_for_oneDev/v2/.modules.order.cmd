@@ -1 +0,0 @@
-savedcmd_/home/zly/桌面/ZTE_OS/IO-monitor/tasksIO_for_oneDev/v2/modules.order := {   echo /home/zly/桌面/ZTE_OS/IO-monitor/tasksIO_for_oneDev/v2/io_monitorv2.o; :; } > /home/zly/桌面/ZTE_OS/IO-monitor/tasksIO_for_oneDev/v2/modules.order
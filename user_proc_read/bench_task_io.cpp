@@ -0,0 +1,186 @@
+// bench_task_io：在 10k/50k/100k 个进程下比较全量扫描耗时
+//   kernel      读取整个 /proc/iomon/tasks（需已加载含 task 采集器的 iomon.ko）
+//   user-1t     用户态采集器，单线程全量扫描
+//   user-Nt     用户态采集器，N 线程全量扫描（N 为 1 时不重复测试）
+//   user-incr   用户态采集器，N 线程增量模式的第二次及以后的扫描
+//
+// 用法：bench_task_io [-j 线程数] [-r 重复次数] [进程数...]
+// 进程数不足时 fork 出阻塞在管道上的子进程补足；受 pid_max / RLIMIT_NPROC 限制时
+// 以实际达到的进程数测试。
+
+#include "task_io_collector.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Children {
+    int pipe_w = -1;
+    int pipe_r = -1;
+    std::vector<pid_t> pids;
+
+    // 子进程阻塞在 read() 上，父进程关闭写端后全部退出
+    bool spawn(size_t n)
+    {
+        if (pipe_w < 0) {
+            int fds[2];
+            if (pipe2(fds, O_CLOEXEC) < 0)
+                return false;
+            pipe_r = fds[0];
+            pipe_w = fds[1];
+        }
+        while (n--) {
+            pid_t pid = fork();
+            if (pid < 0)
+                return false;
+            if (pid == 0) {
+                char c;
+                close(pipe_w);
+                while (read(pipe_r, &c, 1) < 0 && errno == EINTR) {
+                }
+                _exit(0);
+            }
+            pids.push_back(pid);
+        }
+        return true;
+    }
+
+    ~Children()
+    {
+        if (pipe_w >= 0)
+            close(pipe_w);
+        if (pipe_r >= 0)
+            close(pipe_r);
+        for (pid_t pid : pids)
+            waitpid(pid, nullptr, 0);
+    }
+};
+
+size_t count_processes()
+{
+    taskio::Collector c(taskio::Collector::Options{});
+    return c.scan() ? c.rows().size() : 0;
+}
+
+// 重复执行 fn，返回最短和平均耗时（毫秒）
+void time_it(int repeat, const std::function<bool()> &fn, double &best, double &avg)
+{
+    double total = 0;
+
+    best = 1e300;
+    for (int i = 0; i < repeat; i++) {
+        auto t0 = Clock::now();
+        if (!fn()) {
+            best = avg = -1;
+            return;
+        }
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        best = std::min(best, ms);
+        total += ms;
+    }
+    avg = total / repeat;
+}
+
+bool read_kernel_table()
+{
+    static std::vector<char> buf(1 << 20);
+    int fd = open("/proc/iomon/tasks", O_RDONLY | O_CLOEXEC);
+    ssize_t n;
+
+    if (fd < 0)
+        return false;
+    while ((n = read(fd, buf.data(), buf.size())) > 0) {
+    }
+    close(fd);
+    return n == 0;
+}
+
+void report(const char *name, size_t procs, double best, double avg)
+{
+    if (best < 0)
+        printf("%-10s %-10zu %-12s %-12s\n", name, procs, "n/a", "n/a");
+    else
+        printf("%-10s %-10zu %-12.2f %-12.2f\n", name, procs, best, avg);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    unsigned threads = std::thread::hardware_concurrency();
+    int repeat = 5;
+    std::vector<size_t> targets;
+    Children children;
+    int c;
+
+    while ((c = getopt(argc, argv, "j:r:h")) != -1) {
+        switch (c) {
+        case 'j':
+            threads = static_cast<unsigned>(strtoul(optarg, nullptr, 10));
+            break;
+        case 'r':
+            repeat = std::max(1, atoi(optarg));
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-j threads] [-r repeat] [nprocs...]\n", argv[0]);
+            return c == 'h' ? 0 : 1;
+        }
+    }
+    if (threads == 0)
+        threads = 1;
+    for (int i = optind; i < argc; i++)
+        targets.push_back(strtoul(argv[i], nullptr, 10));
+    if (targets.empty())
+        targets = {10000, 50000, 100000};
+    std::sort(targets.begin(), targets.end());
+
+    printf("%-10s %-10s %-12s %-12s\n", "MODE", "NPROCS", "BEST(ms)", "AVG(ms)");
+    for (size_t target : targets) {
+        size_t have = count_processes();
+        if (have < target && !children.spawn(target - have)) {
+            int err = errno;
+            fprintf(stderr, "bench_task_io: fork stopped at %zu processes: %s\n",
+                    count_processes(), strerror(err));
+        }
+        size_t procs = count_processes();
+        double best, avg;
+
+        time_it(repeat, read_kernel_table, best, avg);
+        report("kernel", procs, best, avg);
+
+        taskio::Collector single(taskio::Collector::Options{1, false});
+        time_it(repeat, [&] { return single.scan() && !single.format().empty(); }, best, avg);
+        report("user-1t", procs, best, avg);
+
+        if (threads > 1) {
+            taskio::Collector multi(taskio::Collector::Options{threads, false});
+            time_it(repeat, [&] { return multi.scan() && !multi.format().empty(); }, best, avg);
+            char name[32];
+            snprintf(name, sizeof(name), "user-%ut", threads);
+            report(name, procs, best, avg);
+        }
+
+        taskio::Collector incr(taskio::Collector::Options{threads, true});
+        incr.scan(); // 首次扫描建立缓存，不计时
+        time_it(repeat, [&] { return incr.scan() && !incr.format().empty(); }, best, avg);
+        report("user-incr", procs, best, avg);
+
+        if (procs < target)
+            break;
+    }
+    return 0;
+}
@@ -0,0 +1,491 @@
+#include "task_io_collector.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace taskio {
+
+namespace {
+
+// getdents64 返回的目录项布局
+struct linux_dirent64 {
+    unsigned long long d_ino;
+    long long d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+constexpr size_t kReadBufSize = 64 * 1024;
+constexpr size_t kDentsBufSize = 256 * 1024;
+constexpr size_t kChunk = 64;       // 线程池每次领取的 PID 数
+constexpr size_t kFdReserve = 64;   // 给 stdio、/proc 及临时文件预留的 fd
+
+// 把无符号整数写到 p，返回写入后的位置（不加结尾 0）
+char *put_uint(char *p, unsigned v)
+{
+    char tmp[12];
+    int n = 0;
+
+    do {
+        tmp[n++] = static_cast<char>('0' + v % 10);
+        v /= 10;
+    } while (v);
+    while (n)
+        *p++ = tmp[--n];
+    return p;
+}
+
+// 读取整个小文件到 buf，返回长度，失败返回 -1
+ssize_t read_at(int dirfd, const char *path, std::vector<char> &buf)
+{
+    int fd = openat(dirfd, path, O_RDONLY | O_CLOEXEC);
+    size_t len = 0;
+
+    if (fd < 0)
+        return -1;
+    for (;;) {
+        ssize_t n = read(fd, buf.data() + len, buf.size() - 1 - len);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            close(fd);
+            return -1;
+        }
+        if (n == 0)
+            break;
+        len += static_cast<size_t>(n);
+        if (len == buf.size() - 1)
+            buf.resize(buf.size() * 2);
+    }
+    close(fd);
+    buf[len] = '\0';
+    return static_cast<ssize_t>(len);
+}
+
+// 手写扫描器：解析十进制数并跳过其后的一个分隔符
+unsigned long long scan_ull(const char *&p, const char *end)
+{
+    unsigned long long v = 0;
+
+    while (p < end && *p >= '0' && *p <= '9')
+        v = v * 10 + static_cast<unsigned>(*p++ - '0');
+    if (p < end)
+        p++;
+    return v;
+}
+
+long long scan_ll(const char *&p, const char *end)
+{
+    if (p < end && *p == '-') {
+        p++;
+        return -static_cast<long long>(scan_ull(p, end));
+    }
+    return static_cast<long long>(scan_ull(p, end));
+}
+
+void skip_fields(const char *&p, const char *end, int n)
+{
+    while (n-- > 0) {
+        while (p < end && *p != ' ')
+            p++;
+        if (p < end)
+            p++;
+    }
+}
+
+// 在 [p, end) 中查找 key 并解析其后的数字，未找到返回 false
+bool scan_key(const char *p, const char *end, const char *key, size_t key_len,
+              unsigned long long &out)
+{
+    const char *hit = static_cast<const char *>(memmem(p, end - p, key, key_len));
+
+    if (!hit)
+        return false;
+    hit += key_len;
+    while (hit < end && (*hit == ' ' || *hit == '\t'))
+        hit++;
+    out = scan_ull(hit, end);
+    return true;
+}
+
+// /proc/[pid]/stat 只给出状态字母，这里换算成该字母对应的 task->__state 典型值（5.14+ 内核）
+long state_from_char(char c)
+{
+    switch (c) {
+    case 'R': return 0x0000;   // TASK_RUNNING
+    case 'S': return 0x0001;   // TASK_INTERRUPTIBLE
+    case 'D': return 0x0002;   // TASK_UNINTERRUPTIBLE
+    case 'T': return 0x0104;   // TASK_STOPPED = TASK_WAKEKILL | __TASK_STOPPED
+    case 't': return 0x0008;   // TASK_TRACED
+    case 'P': return 0x0040;   // TASK_PARKED
+    case 'I': return 0x0402;   // TASK_IDLE = TASK_UNINTERRUPTIBLE | TASK_NOLOAD
+    case 'Z':                  // 僵尸/已退出的任务 __state 均为 TASK_DEAD
+    case 'X': return 0x0080;
+    default:  return 0;
+    }
+}
+
+} // namespace
+
+ThreadPool::ThreadPool(unsigned threads)
+{
+    for (unsigned i = 1; i < threads; i++)
+        workers_.emplace_back(&ThreadPool::worker_loop, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto &t : workers_)
+        t.join();
+}
+
+void ThreadPool::run(size_t n, size_t chunk,
+                     const std::function<void(unsigned, size_t, size_t)> &fn)
+{
+    if (n == 0)
+        return;
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        job_ = &fn;
+        job_n_ = n;
+        job_chunk_ = chunk ? chunk : 1;
+        next_.store(0, std::memory_order_relaxed);
+        busy_ = static_cast<unsigned>(workers_.size());
+        round_++;
+    }
+    start_cv_.notify_all();
+    drain(0);
+
+    std::unique_lock<std::mutex> lk(mutex_);
+    done_cv_.wait(lk, [this] { return busy_ == 0; });
+    job_ = nullptr;
+}
+
+void ThreadPool::worker_loop(unsigned id)
+{
+    unsigned long seen = 0;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lk(mutex_);
+            start_cv_.wait(lk, [&] { return stop_ || round_ != seen; });
+            if (stop_)
+                return;
+            seen = round_;
+        }
+        drain(id);
+        {
+            std::lock_guard<std::mutex> lk(mutex_);
+            if (--busy_ == 0)
+                done_cv_.notify_one();
+        }
+    }
+}
+
+void ThreadPool::drain(unsigned id)
+{
+    for (;;) {
+        size_t begin = next_.fetch_add(job_chunk_, std::memory_order_relaxed);
+        if (begin >= job_n_)
+            break;
+        (*job_)(id, begin, std::min(begin + job_chunk_, job_n_));
+    }
+}
+
+Collector::Collector(const Options &opts)
+    : opts_(opts), pool_(opts.threads ? opts.threads : 1)
+{
+    struct rlimit rl;
+    long page = sysconf(_SC_PAGESIZE);
+
+    if (page > 0)
+        page_kb_ = static_cast<unsigned long>(page) / 1024;
+
+    proc_fd_ = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+    // 增量模式为每个 PID 常驻一个目录 fd，尽量把软限制提到硬限制
+    if (opts_.incremental && getrlimit(RLIMIT_NOFILE, &rl) == 0) {
+        if (rl.rlim_cur < rl.rlim_max) {
+            rl.rlim_cur = rl.rlim_max;
+            setrlimit(RLIMIT_NOFILE, &rl);
+            getrlimit(RLIMIT_NOFILE, &rl);
+        }
+        size_t reserve = kFdReserve + pool_.size() * 2;
+        if (rl.rlim_cur != RLIM_INFINITY && rl.rlim_cur > reserve)
+            dirfd_budget_ = rl.rlim_cur - reserve;
+        else if (rl.rlim_cur == RLIM_INFINITY)
+            dirfd_budget_ = static_cast<size_t>(-1);
+    }
+
+    bufs_.resize(pool_.size());
+    for (auto &b : bufs_)
+        b.data.resize(kReadBufSize);
+    dents_.resize(kDentsBufSize);
+}
+
+Collector::~Collector()
+{
+    for (auto &kv : cache_)
+        close_entry(kv.second);
+    if (proc_fd_ >= 0)
+        close(proc_fd_);
+}
+
+void Collector::close_entry(PidEntry &e)
+{
+    if (e.dirfd >= 0) {
+        close(e.dirfd);
+        e.dirfd = -1;
+        dirfds_open_.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+int Collector::open_pid_dir(int pid)
+{
+    char name[16];
+    int fd;
+
+    if (dirfds_open_.fetch_add(1, std::memory_order_relaxed) >= dirfd_budget_) {
+        dirfds_open_.fetch_sub(1, std::memory_order_relaxed);
+        return -1;
+    }
+    *put_uint(name, static_cast<unsigned>(pid)) = '\0';
+    fd = openat(proc_fd_, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0)
+        dirfds_open_.fetch_sub(1, std::memory_order_relaxed);
+    return fd;
+}
+
+// 用 getdents64 直接列出 /proc 下的数字目录
+bool Collector::list_pids()
+{
+    pids_.clear();
+    if (lseek(proc_fd_, 0, SEEK_SET) < 0)
+        return false;
+
+    for (;;) {
+        long n = syscall(SYS_getdents64, proc_fd_, dents_.data(), dents_.size());
+        if (n < 0)
+            return false;
+        if (n == 0)
+            break;
+        for (long off = 0; off < n;) {
+            auto *d = reinterpret_cast<linux_dirent64 *>(dents_.data() + off);
+            const char *s = d->d_name;
+            unsigned v = 0;
+
+            off += d->d_reclen;
+            if (d->d_type != DT_DIR || *s < '1' || *s > '9')
+                continue;
+            while (*s >= '0' && *s <= '9')
+                v = v * 10 + static_cast<unsigned>(*s++ - '0');
+            if (*s == '\0')
+                pids_.push_back(static_cast<int>(v));
+        }
+    }
+    std::sort(pids_.begin(), pids_.end());
+    return true;
+}
+
+// 采集单个进程；进程在读取过程中退出时 e.alive 保持 false
+void Collector::collect(PidEntry &e, int pid, WorkerBuf &wb)
+{
+    // 路径形如 "1234/stat"（经 /proc fd）或 "stat"（经 PID 目录 fd）
+    char path[48];
+    char *rel = put_uint(path, static_cast<unsigned>(pid));
+    *rel++ = '/';
+    int base_fd = proc_fd_;
+    const char *base_path = path;
+    ssize_t len;
+
+    e.alive = false;
+    if (opts_.incremental && e.dirfd < 0)
+        e.dirfd = open_pid_dir(pid);
+    if (e.dirfd >= 0) {
+        base_fd = e.dirfd;
+        base_path = rel;
+    }
+
+    strcpy(rel, "stat");
+    len = read_at(base_fd, base_path, wb.data);
+    if (len < 0 && e.dirfd >= 0) {
+        // 缓存的目录 fd 指向已退出的旧进程（PID 已复用），重新打开一次
+        close_entry(e);
+        e.have_uid = false;
+        e.dirfd = open_pid_dir(pid);
+        base_fd = e.dirfd >= 0 ? e.dirfd : proc_fd_;
+        base_path = e.dirfd >= 0 ? rel : path;
+        len = read_at(base_fd, base_path, wb.data);
+    }
+    if (len <= 0)
+        return;
+    wb.stat_reads++;
+
+    // stat: "pid (comm) S ppid ..."，comm 可能含空格或括号，以最后一个 ')' 为界
+    const char *buf = wb.data.data();
+    const char *end = buf + len;
+    const char *lp = static_cast<const char *>(memchr(buf, '(', len));
+    const char *rp = static_cast<const char *>(memrchr(buf, ')', len));
+    if (!lp || !rp || rp < lp || rp + 2 >= end)
+        return;
+
+    TaskRow &r = e.row;
+    size_t comm_len = std::min<size_t>(rp - lp - 1, sizeof(r.comm) - 1);
+    memcpy(r.comm, lp + 1, comm_len);
+    r.comm[comm_len] = '\0';
+    r.pid = pid;
+
+    const char *p = rp + 2;
+    char state_char = *p;
+    skip_fields(p, end, 1);                                  // 3 state
+    r.ppid = static_cast<int>(scan_ll(p, end));              // 4 ppid
+    skip_fields(p, end, 9);                                  // 5..13
+    unsigned long long cputime = scan_ull(p, end);           // 14 utime
+    cputime += scan_ull(p, end);                             // 15 stime
+    skip_fields(p, end, 6);                                  // 16..21
+    unsigned long long starttime = scan_ull(p, end);         // 22 starttime
+    unsigned long long vsize = scan_ull(p, end);             // 23 vsize（字节）
+    unsigned long long rss = scan_ull(p, end);               // 24 rss（页）
+
+    r.state = state_from_char(state_char);
+    r.vm_kb = static_cast<unsigned long>(vsize / 1024);
+    r.rss_kb = static_cast<unsigned long>(rss * page_kb_);
+
+    // 增量模式下 status 只为取 UID，在以下任一信号变化时才重读：CPU 时间、状态、
+    // /proc/<pid> 目录的属主（每次 fstat 时按任务当前的有效 UID 计算，setuid 后随之变化）
+    bool need_uid = !opts_.incremental || !e.have_uid || starttime != e.starttime ||
+                    cputime != e.cputime || state_char != e.state_char;
+    struct stat st;
+    if (e.dirfd < 0 || fstat(e.dirfd, &st) != 0) {
+        need_uid = true;
+    } else {
+        need_uid |= st.st_uid != e.owner;
+        e.owner = st.st_uid;
+    }
+    e.starttime = starttime;
+    e.cputime = cputime;
+    e.state_char = state_char;
+
+    unsigned long long v;
+    if (need_uid) {
+        // status 中的 Uid 行第一列为真实 UID，对应 task->cred->uid
+        e.uid = 0;
+        strcpy(rel, "status");
+        len = read_at(base_fd, base_path, wb.data);
+        if (len > 0) {
+            wb.status_reads++;
+            if (scan_key(wb.data.data(), wb.data.data() + len, "\nUid:", 5, v))
+                e.uid = static_cast<int>(v);
+        }
+        e.have_uid = true;
+    }
+
+    // IO 计数每轮都读：进程可能只用不到一个时钟滴答的 CPU 就完成 IO，
+    // 两次采样时又都处于睡眠，CPU 时间和状态都不足以判断 IO 是否变化。
+    // 内核模块读取的是主线程的 ioac，对应 task/<pid>/io 而非汇总全部线程的 <pid>/io
+    r.io_r = 0;
+    r.io_w = 0;
+    char *q = rel;
+    memcpy(q, "task/", 5);
+    q = put_uint(q + 5, static_cast<unsigned>(pid));
+    strcpy(q, "/io");
+    len = read_at(base_fd, base_path, wb.data);
+    if (len > 0) {
+        const char *b = wb.data.data();
+        wb.io_reads++;
+        if (scan_key(b, b + len, "\nread_bytes:", 12, v))
+            r.io_r = static_cast<unsigned long>(v);
+        if (scan_key(b, b + len, "\nwrite_bytes:", 13, v))
+            r.io_w = static_cast<unsigned long>(v);
+    }
+
+    r.uid = e.uid;
+    e.alive = true;
+}
+
+bool Collector::scan()
+{
+    if (proc_fd_ < 0 || !list_pids())
+        return false;
+
+    if (!opts_.incremental)
+        cache_.clear();
+
+    // 先在主线程建好所有条目，并行阶段不再修改哈希表结构
+    work_.clear();
+    work_.reserve(pids_.size());
+    for (int pid : pids_)
+        work_.push_back(&cache_[pid]);
+
+    for (auto &b : bufs_)
+        b.stat_reads = b.status_reads = b.io_reads = 0;
+
+    pool_.run(work_.size(), kChunk, [this](unsigned id, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            collect(*work_[i], pids_[i], bufs_[id]);
+    });
+
+    rows_.clear();
+    rows_.reserve(work_.size());
+    for (PidEntry *e : work_) {
+        if (e->alive)
+            rows_.push_back(e->row);
+    }
+
+    // 清理已退出的进程：本轮未列出或读取失败的条目
+    if (opts_.incremental) {
+        for (auto it = cache_.begin(); it != cache_.end();) {
+            if (!it->second.alive || !std::binary_search(pids_.begin(), pids_.end(), it->first)) {
+                close_entry(it->second);
+                it = cache_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    stats_ = ScanStats();
+    stats_.pids = pids_.size();
+    for (auto &b : bufs_) {
+        stats_.stat_reads += b.stat_reads;
+        stats_.status_reads += b.status_reads;
+        stats_.io_reads += b.io_reads;
+    }
+    return true;
+}
+
+const std::string &Collector::format()
+{
+    char line[192];
+
+    out_.clear();
+    out_.reserve(rows_.size() * 96 + 256);
+    out_ += "PID     COMM             STATE   PPID    UID     VM(KB)    RSS(KB)   IO_R      IO_W\n";
+    out_ += "-------------------------------------------------------------------------------\n";
+    for (const TaskRow &r : rows_) {
+        int n = snprintf(line, sizeof(line),
+                         "%-7d %-16s %-7ld %-7d %-7d %-9lu %-9lu %-10lu %-10lu\n",
+                         r.pid, r.comm, r.state, r.ppid, r.uid,
+                         r.vm_kb, r.rss_kb, r.io_r, r.io_w);
+        if (n > 0)
+            out_.append(line, std::min<size_t>(static_cast<size_t>(n), sizeof(line) - 1));
+    }
+    return out_;
+}
+
+} // namespace taskio
@@ -0,0 +1,139 @@
+#ifndef TASK_IO_COLLECTOR_H
+#define TASK_IO_COLLECTOR_H
+
+// 用户态采集器：在无法加载内核模块的主机上，从 /proc/[pid]/{stat,status,io}
+// 生成与 /proc/task_io_info（task_io_seq_show）完全相同格式的表格
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace taskio {
+
+// 与内核模块 show_task_info 输出的一行对应
+struct TaskRow {
+    int pid = 0;
+    char comm[16] = {};       // TASK_COMM_LEN
+    long state = 0;           // 内核 task->__state 数值
+    int ppid = 0;
+    int uid = 0;
+    unsigned long vm_kb = 0;
+    unsigned long rss_kb = 0;
+    unsigned long io_r = 0;   // 主线程 ioac.read_bytes
+    unsigned long io_w = 0;   // 主线程 ioac.write_bytes
+};
+
+// 固定线程数的线程池：run() 把 [0, n) 按块分给所有线程并等待完成
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(workers_.size()) + 1; }
+
+    // fn(worker_id, begin, end)，worker_id 范围 [0, size())，调用线程也参与工作
+    void run(size_t n, size_t chunk, const std::function<void(unsigned, size_t, size_t)> &fn);
+
+private:
+    void worker_loop(unsigned id);
+    void drain(unsigned id);
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    const std::function<void(unsigned, size_t, size_t)> *job_ = nullptr;
+    size_t job_n_ = 0;
+    size_t job_chunk_ = 1;
+    std::atomic<size_t> next_{0};
+    unsigned long round_ = 0;
+    unsigned busy_ = 0;
+    bool stop_ = false;
+};
+
+class Collector {
+public:
+    struct Options {
+        unsigned threads = 1;
+        // 增量模式：保留每个 PID 的目录 fd 和上次的 UID，
+        // 只有 CPU 时间、状态或目录属主变化的进程才重新读取 status；io 每轮都读
+        bool incremental = false;
+    };
+
+    // 每次 scan() 的文件读取计数，便于观察增量模式的效果
+    struct ScanStats {
+        size_t pids = 0;
+        size_t stat_reads = 0;
+        size_t status_reads = 0;
+        size_t io_reads = 0;
+    };
+
+    explicit Collector(const Options &opts);
+    ~Collector();
+
+    Collector(const Collector &) = delete;
+    Collector &operator=(const Collector &) = delete;
+
+    // 扫描一次 /proc，失败（无法打开 /proc）时返回 false
+    bool scan();
+
+    // 按 task_io_seq_show 的格式输出最近一次扫描结果；返回的引用在下次调用前有效
+    const std::string &format();
+
+    const std::vector<TaskRow> &rows() const { return rows_; }
+    const ScanStats &last_stats() const { return stats_; }
+
+private:
+    // 每个 PID 的缓存；只在增量模式下跨扫描保留
+    struct PidEntry {
+        int dirfd = -1;
+        unsigned long long starttime = 0; // 用于识别 PID 复用
+        unsigned long long cputime = 0;   // utime + stime
+        char state_char = 0;
+        bool have_uid = false;            // uid 已读取过
+        unsigned owner = 0;               // /proc/<pid> 目录属主，变化时重读 uid
+        int uid = 0;
+        bool alive = false;               // 本次扫描成功读取
+        TaskRow row;
+    };
+
+    // 每个工作线程独占的读缓冲区
+    struct WorkerBuf {
+        std::vector<char> data;
+        size_t stat_reads = 0;
+        size_t status_reads = 0;
+        size_t io_reads = 0;
+    };
+
+    bool list_pids();
+    void collect(PidEntry &e, int pid, WorkerBuf &wb);
+    int open_pid_dir(int pid);
+    void close_entry(PidEntry &e);
+
+    Options opts_;
+    int proc_fd_ = -1;
+    size_t dirfd_budget_ = 0;
+    std::atomic<size_t> dirfds_open_{0};
+    unsigned long page_kb_ = 4;
+    ThreadPool pool_;
+    std::vector<WorkerBuf> bufs_;
+    std::vector<char> dents_;
+    std::vector<int> pids_;
+    std::vector<PidEntry *> work_;
+    std::unordered_map<int, PidEntry> cache_;
+    std::vector<TaskRow> rows_;
+    std::string out_;
+    ScanStats stats_;
+};
+
+} // namespace taskio
+
+#endif /* TASK_IO_COLLECTOR_H */